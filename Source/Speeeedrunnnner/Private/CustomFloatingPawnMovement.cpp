@@ -1,10 +1,13 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "CustomFloatingPawnMovement.h"
+#include "HitchDetectorSubsystem.h"
 #include "Engine/HitResult.h"
 #include "GameFramework/Pawn.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/WorldSettings.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(CustomFloatingPawnMovement)
 
@@ -29,11 +32,20 @@ UCustomFloatingPawnMovement::UCustomFloatingPawnMovement(const FObjectInitialize
 	bIsOnGround = false;
 	bIsOnSteepSlope = false;
 
+	// Trajectory prediction
+	TrajectorySimStep = 1.f / 30.f;
+	TrajectoryMaxTime = 3.f;
+	TrajectoryMaxSweeps = 8;
+	TrajectoryCacheTolerance = 1.f;
+	MaxTrajectoryRebuildsPerFrame = 2;
+
 	ResetMoveState();
 }
 
 void UCustomFloatingPawnMovement::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
 {
+    HITCH_SCOPE(Movement);
+
     if (ShouldSkipUpdate(DeltaTime))
     {
        return;
@@ -56,7 +68,7 @@ void UCustomFloatingPawnMovement::TickComponent(float DeltaTime, enum ELevelTick
         // Aplica gravidade se não estiver no chão
         if (!bIsOnGround) 
         {
-           Velocity.Z += GravityScale * GravityForce * GravityMultiplier * DeltaTime;
+           Velocity.Z += GetAirGravityZ() * DeltaTime;
         }
 
         const AController* Controller = PawnOwner->GetController();
@@ -139,92 +151,110 @@ bool UCustomFloatingPawnMovement::LimitWorldBounds()
 void UCustomFloatingPawnMovement::ApplyControlInputToVelocity(float DeltaTime)
 {
     const FVector ControlAcceleration = GetPendingInputVector().GetClampedToMaxSize(1.f);
-    const float AnalogInputModifier = (ControlAcceleration.SizeSquared() > 0.f ? ControlAcceleration.Size() : 0.f);
-    const float MaxPawnSpeed = GetMaxSpeed() * AnalogInputModifier;
     
     // 1. Separar a velocidade Vertical da Horizontal para proteger a gravidade
     float OldVelocityZ = Velocity.Z;
     FVector HorizontalVelocity = FVector(Velocity.X, Velocity.Y, 0.f);
-    float CurrentHorizontalSpeed = HorizontalVelocity.Size();
 
     // ==========================================
     // LÓGICA DE CHÃO
     // ==========================================
     if (bIsOnGround)
     {
-        // Se tem input, aplica o Turning Boost (curva rápida)
-        if (AnalogInputModifier > 0.f && CurrentHorizontalSpeed > 0.f)
-        {
-            const float TimeScale = FMath::Clamp(DeltaTime * TurningBoost, 0.f, 1.f);
-            // Essa formula mágica gira o vetor de velocidade em direção ao Input sem perder magnitude
-            HorizontalVelocity = HorizontalVelocity + (ControlAcceleration * CurrentHorizontalSpeed - HorizontalVelocity) * TimeScale;
-        }
-
-        // Deceleração (Fricção) quando solta o controle
-        if (AnalogInputModifier == 0.f && CurrentHorizontalSpeed > 0.f)
-        {
-            const float NewHorizontalSpeed = FMath::Max(CurrentHorizontalSpeed - FMath::Abs(Deceleration) * DeltaTime, 0.f);
-            HorizontalVelocity = HorizontalVelocity.GetSafeNormal() * NewHorizontalSpeed;
-        }
-
-        // Aceleração Padrão
-        const bool bExceedingMaxSpeed = CurrentHorizontalSpeed > MaxPawnSpeed;
-        const float TargetMaxSpeed = bExceedingMaxSpeed ? CurrentHorizontalSpeed : MaxPawnSpeed;
-        
-        HorizontalVelocity += ControlAcceleration * FMath::Abs(Acceleration) * DeltaTime;
-        HorizontalVelocity = HorizontalVelocity.GetClampedToMaxSize(TargetMaxSpeed);
+        HorizontalVelocity = ComputeGroundHorizontalVelocity(HorizontalVelocity, ControlAcceleration, DeltaTime);
     }
     // ==========================================
     // LÓGICA DE AR (AQUI ESTÁ A CORREÇÃO)
     // ==========================================
     else 
     {
-        if (AnalogInputModifier > 0.f)
+        HorizontalVelocity = ComputeAirHorizontalVelocity(HorizontalVelocity, ControlAcceleration, DeltaTime);
+    }
+
+    // Reconstrói o vetor final com a Gravidade original
+    Velocity = FVector(HorizontalVelocity.X, HorizontalVelocity.Y, OldVelocityZ);
+
+    ConsumeInputVector();
+}
+
+FVector UCustomFloatingPawnMovement::ComputeGroundHorizontalVelocity(const FVector& InHorizontalVelocity, const FVector& ControlAcceleration, float DeltaTime) const
+{
+    const float AnalogInputModifier = (ControlAcceleration.SizeSquared() > 0.f ? ControlAcceleration.Size() : 0.f);
+    const float MaxPawnSpeed = GetMaxSpeed() * AnalogInputModifier;
+
+    FVector HorizontalVelocity = InHorizontalVelocity;
+    const float CurrentHorizontalSpeed = HorizontalVelocity.Size();
+
+    // Se tem input, aplica o Turning Boost (curva rápida)
+    if (AnalogInputModifier > 0.f && CurrentHorizontalSpeed > 0.f)
+    {
+        const float TimeScale = FMath::Clamp(DeltaTime * TurningBoost, 0.f, 1.f);
+        // Essa formula mágica gira o vetor de velocidade em direção ao Input sem perder magnitude
+        HorizontalVelocity = HorizontalVelocity + (ControlAcceleration * CurrentHorizontalSpeed - HorizontalVelocity) * TimeScale;
+    }
+
+    // Deceleração (Fricção) quando solta o controle
+    if (AnalogInputModifier == 0.f && CurrentHorizontalSpeed > 0.f)
+    {
+        const float NewHorizontalSpeed = FMath::Max(CurrentHorizontalSpeed - FMath::Abs(Deceleration) * DeltaTime, 0.f);
+        HorizontalVelocity = HorizontalVelocity.GetSafeNormal() * NewHorizontalSpeed;
+    }
+
+    // Aceleração Padrão
+    const bool bExceedingMaxSpeed = CurrentHorizontalSpeed > MaxPawnSpeed;
+    const float TargetMaxSpeed = bExceedingMaxSpeed ? CurrentHorizontalSpeed : MaxPawnSpeed;
+    
+    HorizontalVelocity += ControlAcceleration * FMath::Abs(Acceleration) * DeltaTime;
+    return HorizontalVelocity.GetClampedToMaxSize(TargetMaxSpeed);
+}
+
+FVector UCustomFloatingPawnMovement::ComputeAirHorizontalVelocity(const FVector& InHorizontalVelocity, const FVector& ControlAcceleration, float DeltaTime) const
+{
+    FVector HorizontalVelocity = InHorizontalVelocity;
+    const float CurrentHorizontalSpeed = HorizontalVelocity.Size();
+
+    if (ControlAcceleration.SizeSquared() > 0.f)
+    {
+        // 1. STEERING NO AR (O PULO DO GATO)
+        // Usamos o AirControl para definir o quão forte conseguimos "girar" o vetor no ar.
+        // Se AirControl for 1.0, vira igual no chão. Se for 0.1, vira muito pouco.
+        if (CurrentHorizontalSpeed > 0.f)
         {
-            // 1. STEERING NO AR (O PULO DO GATO)
-            // Usamos o AirControl para definir o quão forte conseguimos "girar" o vetor no ar.
-            // Se AirControl for 1.0, vira igual no chão. Se for 0.1, vira muito pouco.
-            if (CurrentHorizontalSpeed > 0.f)
-            {
-                // Multiplicamos o TurningBoost pelo AirControl
-                const float AirTurnScale = FMath::Clamp(DeltaTime * TurningBoost * AirControl, 0.f, 1.f);
-                HorizontalVelocity = HorizontalVelocity + (ControlAcceleration * CurrentHorizontalSpeed - HorizontalVelocity) * AirTurnScale;
-            }
+            // Multiplicamos o TurningBoost pelo AirControl
+            const float AirTurnScale = FMath::Clamp(DeltaTime * TurningBoost * AirControl, 0.f, 1.f);
+            HorizontalVelocity = HorizontalVelocity + (ControlAcceleration * CurrentHorizontalSpeed - HorizontalVelocity) * AirTurnScale;
+        }
 
-            // 2. ACELERAÇÃO NO AR
-            // Adiciona velocidade na direção do input (para ganhar velocidade se estiver parado ou lento)
-            FVector AirAccel = ControlAcceleration * FMath::Abs(Acceleration) * AirControl * DeltaTime;
-            HorizontalVelocity += AirAccel;
+        // 2. ACELERAÇÃO NO AR
+        // Adiciona velocidade na direção do input (para ganhar velocidade se estiver parado ou lento)
+        FVector AirAccel = ControlAcceleration * FMath::Abs(Acceleration) * AirControl * DeltaTime;
+        HorizontalVelocity += AirAccel;
 
-            // 3. LIMITAR VELOCIDADE NO AR (OPCIONAL)
-            // Isso impede que ele acelere infinitamente, mas respeita se ele já estava rápido (ex: lançado por uma mola)
-            const float AirMaxSpeed = MaxSpeed; 
-            if (HorizontalVelocity.Size() > AirMaxSpeed)
+        // 3. LIMITAR VELOCIDADE NO AR (OPCIONAL)
+        // Isso impede que ele acelere infinitamente, mas respeita se ele já estava rápido (ex: lançado por uma mola)
+        const float AirMaxSpeed = MaxSpeed; 
+        if (HorizontalVelocity.Size() > AirMaxSpeed)
+        {
+            // Se já estamos rápidos, só clampamos se tentarmos acelerar AINDA MAIS.
+            // Caso contrário, mantemos a velocidade atual (preserva momentum de launch pads)
+            float SpeedToClamp = FMath::Max(CurrentHorizontalSpeed, AirMaxSpeed);
+            
+            // Se o input estiver oposto à velocidade, permitimos reduzir a velocidade (freio aéreo)
+            // Se não quiser freio aéreo, remova a lógica abaixo e use apenas o GetClampedToMaxSize normal.
+            bool bMovingAgainstInput = (FVector::DotProduct(HorizontalVelocity.GetSafeNormal(), ControlAcceleration) < -0.2f);
+            if(bMovingAgainstInput)
             {
-                // Se já estamos rápidos, só clampamos se tentarmos acelerar AINDA MAIS.
-                // Caso contrário, mantemos a velocidade atual (preserva momentum de launch pads)
-                float SpeedToClamp = FMath::Max(CurrentHorizontalSpeed, AirMaxSpeed);
-                
-                // Se o input estiver oposto à velocidade, permitimos reduzir a velocidade (freio aéreo)
-                // Se não quiser freio aéreo, remova a lógica abaixo e use apenas o GetClampedToMaxSize normal.
-                bool bMovingAgainstInput = (FVector::DotProduct(HorizontalVelocity.GetSafeNormal(), ControlAcceleration) < -0.2f);
-                if(bMovingAgainstInput)
-                {
-                     // Permite desacelerar no ar
-                     SpeedToClamp = AirMaxSpeed;
-                }
-
-                HorizontalVelocity = HorizontalVelocity.GetClampedToMaxSize(SpeedToClamp);
+                 // Permite desacelerar no ar
+                 SpeedToClamp = AirMaxSpeed;
             }
+
+            HorizontalVelocity = HorizontalVelocity.GetClampedToMaxSize(SpeedToClamp);
         }
-        // Nota: Não aplicamos Deceleration (fricção) no ar quando solta o controle, 
-        // para manter o arco do pulo natural.
     }
+    // Nota: Não aplicamos Deceleration (fricção) no ar quando solta o controle, 
+    // para manter o arco do pulo natural.
 
-    // Reconstrói o vetor final com a Gravidade original
-    Velocity = FVector(HorizontalVelocity.X, HorizontalVelocity.Y, OldVelocityZ);
-
-    ConsumeInputVector();
+    return HorizontalVelocity;
 }
 
 bool UCustomFloatingPawnMovement::ResolvePenetrationImpl(const FVector& Adjustment, const FHitResult& Hit, const FQuat& NewRotationQuat)
@@ -274,16 +304,8 @@ void UCustomFloatingPawnMovement::CheckGround()
 		LastGroundHit = HitResult;
 		bIsOnGround = true;
 
-		// Calculate the angle of the slope RELATIVE TO GRAVITY DIRECTION
-		// Use DownVector when inverted, UpVector when normal
-		const FVector GravityUpVector = GravityScale < 0.f ? FVector::DownVector : FVector::UpVector;
-		const float SlopeAngle = FMath::RadiansToDegrees(FMath::Acos(FVector::DotProduct(HitResult.Normal, GravityUpVector)));
-
-		// PRINT SLOPE ANGLE
-//		GEngine->AddOnScreenDebugMessage(-1, 0.0f, FColor::Yellow, FString::Printf(TEXT("Slope Angle: %.2f degrees (GravityScale: %.1f)"), SlopeAngle, GravityScale));
-
 		// Check if the slope is too steep
-		bIsOnSteepSlope = (SlopeAngle > MaxWalkableAngle);
+		bIsOnSteepSlope = IsSteepGround(HitResult.Normal);
 
 		// Zero out velocity in the direction of gravity when on ground
 		if (!bIsOnSteepSlope)
@@ -313,49 +335,336 @@ void UCustomFloatingPawnMovement::CheckGround()
 	}
 }
 
+bool UCustomFloatingPawnMovement::IsSteepGround(const FVector& GroundNormal) const
+{
+	// Calculate the angle of the slope RELATIVE TO GRAVITY DIRECTION
+	// Use DownVector when inverted, UpVector when normal
+	const FVector GravityUpVector = GravityScale < 0.f ? FVector::DownVector : FVector::UpVector;
+	const float SlopeAngle = FMath::RadiansToDegrees(FMath::Acos(FVector::DotProduct(GroundNormal, GravityUpVector)));
+
+	// PRINT SLOPE ANGLE
+//	GEngine->AddOnScreenDebugMessage(-1, 0.0f, FColor::Yellow, FString::Printf(TEXT("Slope Angle: %.2f degrees (GravityScale: %.1f)"), SlopeAngle, GravityScale));
+
+	return SlopeAngle > MaxWalkableAngle;
+}
+
 void UCustomFloatingPawnMovement::ApplyGroundFriction(float DeltaTime)
 {
-	if (!bIsOnGround || Velocity.SizeSquared() < KINDA_SMALL_NUMBER)
+	if (!bIsOnGround)
 	{
 		return;
 	}
 
+	Velocity = ComputeGroundFrictionVelocity(Velocity, LastGroundHit.Normal, bIsOnSteepSlope, DeltaTime);
+}
+
+FVector UCustomFloatingPawnMovement::ComputeGroundFrictionVelocity(const FVector& InVelocity, const FVector& GroundNormal, bool bSteepSlope, float DeltaTime) const
+{
+	if (InVelocity.SizeSquared() < KINDA_SMALL_NUMBER)
+	{
+		return InVelocity;
+	}
+
 	// Get horizontal velocity (X and Y only)
-	FVector HorizontalVelocity = FVector(Velocity.X, Velocity.Y, 0.f);
+	FVector HorizontalVelocity = FVector(InVelocity.X, InVelocity.Y, 0.f);
 	const float HorizontalSpeed = HorizontalVelocity.Size();
 
-	if (HorizontalSpeed > KINDA_SMALL_NUMBER)
+	if (HorizontalSpeed <= KINDA_SMALL_NUMBER)
+	{
+		return InVelocity;
+	}
+
+	// Choose friction based on slope
+	float FrictionToApply = bSteepSlope ? SlopeFriction : GroundFriction;
+
+	// On steep slopes, apply friction in the direction opposite to the slope's pull
+	if (bSteepSlope)
+	{
+		// Project the slope normal onto the horizontal plane to get slide direction
+		FVector SlopeDirection = FVector(GroundNormal.X, GroundNormal.Y, 0.f);
+		if (SlopeDirection.SizeSquared() > KINDA_SMALL_NUMBER)
+		{
+			SlopeDirection.Normalize();
+			
+			// Apply friction against the sliding direction
+			const float SlideSpeed = FVector::DotProduct(HorizontalVelocity, SlopeDirection);
+			if (FMath::Abs(SlideSpeed) > KINDA_SMALL_NUMBER)
+			{
+				const FVector FrictionForce = -SlopeDirection * SlideSpeed * FrictionToApply * DeltaTime;
+				HorizontalVelocity += FrictionForce;
+			}
+		}
+	}
+	else
+	{
+		// On flat ground, apply friction to all horizontal movement
+		const float NewHorizontalSpeed = FMath::Max(0.f, HorizontalSpeed - FrictionToApply * DeltaTime * 100.f);
+		HorizontalVelocity = HorizontalVelocity.GetSafeNormal() * NewHorizontalSpeed;
+	}
+
+	// Update velocity with modified horizontal component
+	return FVector(HorizontalVelocity.X, HorizontalVelocity.Y, InVelocity.Z);
+}
+
+bool UCustomFloatingPawnMovement::PredictTrajectory(const FVector& StartLocation, const FVector& LaunchVelocity, const FVector& AirInput, FPawnTrajectory& OutTrajectory, const AActor* IgnoredActor) const
+{
+	HITCH_SCOPE(PredictTrajectory);
+
+	OutTrajectory = FPawnTrajectory();
+	OutTrajectory.Points.Add(StartLocation);
+	OutTrajectory.LandingLocation = StartLocation;
+	OutTrajectory.LandingVelocity = LaunchVelocity;
+
+	const UWorld* World = GetWorld();
+	if (!World || !UpdatedComponent)
+	{
+		return false;
+	}
+
+	const float Step = FMath::Max(TrajectorySimStep, 0.005f);
+	const int32 NumSteps = FMath::Max(FMath::CeilToInt(TrajectoryMaxTime / Step), 1);
+	const int32 StepsPerChord = FMath::DivideAndRoundUp(NumSteps, FMath::Max(TrajectoryMaxSweeps, 1));
+	const FVector ControlAcceleration = AirInput.GetClampedToMaxSize(1.f);
+	const float GravityZ = GetAirGravityZ();
+	const FQuat Rotation = UpdatedComponent->GetComponentQuat();
+
+	// Sweep do corpo com a mesma forma/canal que o SafeMoveUpdatedComponent usaria
+	FCollisionQueryParams SweepParams(SCENE_QUERY_STAT(PredictTrajectorySweep), false, PawnOwner);
+	FCollisionResponseParams SweepResponse;
+	FCollisionShape BodyShape;
+	if (UpdatedPrimitive)
 	{
-		// Choose friction based on slope
-		float FrictionToApply = bIsOnSteepSlope ? SlopeFriction : GroundFriction;
+		UpdatedPrimitive->InitSweepCollisionParams(SweepParams, SweepResponse);
+		BodyShape = UpdatedPrimitive->GetCollisionShape();
+	}
+	if (IgnoredActor)
+	{
+		SweepParams.AddIgnoredActor(IgnoredActor);
+	}
+	const ECollisionChannel BodyChannel = UpdatedComponent->GetCollisionObjectType();
 
-		// On steep slopes, apply friction in the direction opposite to the slope's pull
-		if (bIsOnSteepSlope)
+	// Mesmo trace do CheckGround (sem ignorar o launch pad, o tick também não ignora)
+	FCollisionQueryParams GroundParams(SCENE_QUERY_STAT(PredictTrajectoryGround), false, PawnOwner);
+	auto TraceGround = [&](const FVector& Location, FHitResult& OutHit)
+	{
+		return World->LineTraceSingleByChannel(OutHit, Location, Location - FVector(0.f, 0.f, GroundTraceDistance), ECC_Visibility, GroundParams) && OutHit.bBlockingHit;
+	};
+
+	// CheckGround zera a velocidade (ou seja, "pousa") em chão andável quando ela aponta para o lado da gravidade
+	auto IsLanding = [&](bool bSteepSlope, const FVector& InVelocity)
+	{
+		if (bSteepSlope)
 		{
-			// Project the slope normal onto the horizontal plane to get slide direction
-			FVector SlopeDirection = FVector(LastGroundHit.Normal.X, LastGroundHit.Normal.Y, 0.f);
-			if (SlopeDirection.SizeSquared() > KINDA_SMALL_NUMBER)
+			return false;
+		}
+		return GravityScale < 0.f ? InVelocity.Z > 0.f : InVelocity.Z < 0.f;
+	};
+
+	FVector SimLocation = StartLocation;
+	FVector SimVelocity = LaunchVelocity;
+	float SimTime = 0.f;
+
+	FHitResult GroundHit;
+	bool bOnGround = TraceGround(SimLocation, GroundHit);
+
+	// Velocidade usada em cada passo do trecho atual, para saber a velocidade no ponto do hit
+	TArray<FVector, TInlineAllocator<32>> ChordVelocities;
+
+	// O chão é checado a cada passo como no tick; só o sweep do corpo é feito uma vez por trecho (chord) de StepsPerChord passos
+	for (int32 StepIndex = 0; StepIndex < NumSteps; )
+	{
+		const int32 ChordFirstPoint = OutTrajectory.Points.Num() - 1;
+		const FVector ChordStart = SimLocation;
+		const float ChordStartTime = SimTime;
+		const int32 ChordSteps = FMath::Min(StepsPerChord, NumSteps - StepIndex);
+		ChordVelocities.Reset();
+
+		int32 ChordStep = 0;
+		bool bLandedOnGround = false;
+		for (; ChordStep < ChordSteps; ++ChordStep)
+		{
+			// Mesma ordem do TickComponent: gravidade (com o estado do passo anterior), CheckGround, input, fricção, move
+			if (!bOnGround)
+			{
+				SimVelocity.Z += GravityZ * Step;
+			}
+
+			bOnGround = TraceGround(SimLocation, GroundHit);
+			const bool bSteepSlope = bOnGround && IsSteepGround(GroundHit.Normal);
+			if (bOnGround && IsLanding(bSteepSlope, SimVelocity))
+			{
+				bLandedOnGround = true;
+				break;
+			}
+
+			// Perto do chão (dentro do GroundTraceDistance) o tick usa a lógica de chão, inclusive logo depois de sair de um launch pad
+			const FVector HorizontalVelocity = bOnGround
+				? ComputeGroundHorizontalVelocity(FVector(SimVelocity.X, SimVelocity.Y, 0.f), ControlAcceleration, Step)
+				: ComputeAirHorizontalVelocity(FVector(SimVelocity.X, SimVelocity.Y, 0.f), ControlAcceleration, Step);
+			SimVelocity = FVector(HorizontalVelocity.X, HorizontalVelocity.Y, SimVelocity.Z);
+
+			if (bOnGround)
+			{
+				SimVelocity = ComputeGroundFrictionVelocity(SimVelocity, GroundHit.Normal, bSteepSlope, Step);
+			}
+
+			ChordVelocities.Add(SimVelocity);
+			SimLocation += SimVelocity * Step;
+			SimTime += Step;
+			OutTrajectory.Points.Add(SimLocation);
+		}
+		StepIndex += ChordSteps;
+
+		// Bateu em algo no caminho. Hits que já começam penetrando (ex: o pawn encostado no chão ou no launch pad)
+		// são ignorados só neste trecho, com uma cópia dos params, para a superfície continuar valendo no resto do voo.
+		FHitResult SweepHit;
+		bool bSweepHit = false;
+		if (ChordStep > 0)
+		{
+			FCollisionQueryParams ChordSweepParams = SweepParams;
+			for (int32 Attempt = 0; Attempt < 4; ++Attempt)
 			{
-				SlopeDirection.Normalize();
-				
-				// Apply friction against the sliding direction
-				const float SlideSpeed = FVector::DotProduct(HorizontalVelocity, SlopeDirection);
-				if (FMath::Abs(SlideSpeed) > KINDA_SMALL_NUMBER)
+				bSweepHit = World->SweepSingleByChannel(SweepHit, ChordStart, SimLocation, Rotation, BodyChannel, BodyShape, ChordSweepParams, SweepResponse) && SweepHit.bBlockingHit;
+				if (!bSweepHit || !SweepHit.bStartPenetrating || !SweepHit.GetComponent())
 				{
-					const FVector FrictionForce = -SlopeDirection * SlideSpeed * FrictionToApply * DeltaTime;
-					HorizontalVelocity += FrictionForce;
+					break;
 				}
+				ChordSweepParams.AddIgnoredComponent(SweepHit.GetComponent());
+				bSweepHit = false;
+			}
+		}
+
+		if (bSweepHit && !SweepHit.bStartPenetrating)
+		{
+			const int32 StepsBeforeHit = FMath::Clamp(FMath::FloorToInt(SweepHit.Time * ChordStep), 0, ChordStep);
+			OutTrajectory.Points.SetNum(ChordFirstPoint + 1 + StepsBeforeHit);
+			OutTrajectory.Points.Add(SweepHit.Location);
+
+			OutTrajectory.bLanded = true;
+			OutTrajectory.LandingLocation = SweepHit.Location;
+			// Velocidade do passo em que o hit aconteceu, não a do fim do trecho
+			OutTrajectory.LandingVelocity = ChordVelocities[FMath::Min(StepsBeforeHit, ChordStep - 1)];
+			OutTrajectory.FlightTime = ChordStartTime + SweepHit.Time * ChordStep * Step;
+			OutTrajectory.Hit = SweepHit;
+			return true;
+		}
+
+		// O ground check do tick pousaria o pawn aqui
+		if (bLandedOnGround)
+		{
+			OutTrajectory.bLanded = true;
+			OutTrajectory.LandingLocation = SimLocation;
+			OutTrajectory.LandingVelocity = SimVelocity;
+			OutTrajectory.FlightTime = SimTime;
+			OutTrajectory.Hit = GroundHit;
+			return true;
+		}
+	}
+
+	OutTrajectory.LandingLocation = SimLocation;
+	OutTrajectory.LandingVelocity = SimVelocity;
+	OutTrajectory.FlightTime = SimTime;
+	return false;
+}
+
+uint32 UCustomFloatingPawnMovement::GetTrajectorySettingsHash() const
+{
+	uint32 Hash = GetTypeHash(GravityScale);
+	Hash = HashCombine(Hash, GetTypeHash(GetAirGravityZ()));
+	Hash = HashCombine(Hash, GetTypeHash(AirControl));
+	Hash = HashCombine(Hash, GetTypeHash(TurningBoost));
+	Hash = HashCombine(Hash, GetTypeHash(Acceleration));
+	Hash = HashCombine(Hash, GetTypeHash(Deceleration));
+	Hash = HashCombine(Hash, GetTypeHash(GroundFriction));
+	Hash = HashCombine(Hash, GetTypeHash(SlopeFriction));
+	Hash = HashCombine(Hash, GetTypeHash(MaxSpeed));
+	Hash = HashCombine(Hash, GetTypeHash(GroundTraceDistance));
+	Hash = HashCombine(Hash, GetTypeHash(MaxWalkableAngle));
+	Hash = HashCombine(Hash, GetTypeHash(TrajectorySimStep));
+	Hash = HashCombine(Hash, GetTypeHash(TrajectoryMaxTime));
+	Hash = HashCombine(Hash, GetTypeHash(TrajectoryMaxSweeps));
+	return Hash;
+}
+
+bool UCustomFloatingPawnMovement::GetCachedTrajectory(const UObject* Source, const FVector& StartLocation, const FVector& LaunchVelocity, const FVector& AirInput, FPawnTrajectory& OutTrajectory, bool& bOutUpToDate)
+{
+	const uint32 SettingsHash = GetTrajectorySettingsHash();
+	FCachedTrajectory* Cached = TrajectoryCache.Find(Source);
+
+	// Nada mudou: devolve o resultado guardado sem nenhuma query
+	if (Cached
+		&& Cached->bBuilt
+		&& Cached->SettingsHash == SettingsHash
+		&& Cached->StartLocation.Equals(StartLocation, TrajectoryCacheTolerance)
+		&& Cached->LaunchVelocity.Equals(LaunchVelocity, TrajectoryCacheTolerance)
+		&& Cached->AirInput.Equals(AirInput, 0.01f))
+	{
+		OutTrajectory = Cached->Trajectory;
+		bOutUpToDate = true;
+		return OutTrajectory.bLanded;
+	}
+
+	if (!Cached)
+	{
+		// Limpa entradas de objetos que já foram destruídos antes de adicionar uma nova
+		for (auto It = TrajectoryCache.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
 			}
 		}
-		else
+		Cached = &TrajectoryCache.Add(Source);
+		Cached->Trajectory.Points.Add(StartLocation);
+		Cached->Trajectory.LandingLocation = StartLocation;
+		Cached->Trajectory.LandingVelocity = LaunchVelocity;
+	}
+
+	if (TrajectoryRebuildFrame != GFrameCounter)
+	{
+		TrajectoryRebuildFrame = GFrameCounter;
+		TrajectoryRebuildsThisFrame = 0;
+	}
+
+	// Estourou o orçamento deste frame (vale também para Sources novos): usa o resultado antigo e refaz num frame seguinte
+	if (TrajectoryRebuildsThisFrame >= MaxTrajectoryRebuildsPerFrame)
+	{
+		OutTrajectory = Cached->Trajectory;
+		bOutUpToDate = false;
+		return OutTrajectory.bLanded;
+	}
+	++TrajectoryRebuildsThisFrame;
+
+	// O launch pad (ou o dono do componente que pediu) não conta como colisão no caminho
+	const AActor* SourceActor = Cast<AActor>(Source);
+	if (!SourceActor)
+	{
+		if (const UActorComponent* SourceComponent = Cast<UActorComponent>(Source))
 		{
-			// On flat ground, apply friction to all horizontal movement
-			const float NewHorizontalSpeed = FMath::Max(0.f, HorizontalSpeed - FrictionToApply * DeltaTime * 100.f);
-			HorizontalVelocity = HorizontalVelocity.GetSafeNormal() * NewHorizontalSpeed;
+			SourceActor = SourceComponent->GetOwner();
 		}
+	}
+
+	Cached->StartLocation = StartLocation;
+	Cached->LaunchVelocity = LaunchVelocity;
+	Cached->AirInput = AirInput;
+	Cached->SettingsHash = SettingsHash;
+	Cached->bBuilt = true;
+	PredictTrajectory(StartLocation, LaunchVelocity, AirInput, Cached->Trajectory, SourceActor);
 
-		// Update velocity with modified horizontal component
-		Velocity.X = HorizontalVelocity.X;
-		Velocity.Y = HorizontalVelocity.Y;
+	OutTrajectory = Cached->Trajectory;
+	bOutUpToDate = true;
+	return OutTrajectory.bLanded;
+}
+
+void UCustomFloatingPawnMovement::InvalidateTrajectoryCache(const UObject* Source)
+{
+	if (Source)
+	{
+		TrajectoryCache.Remove(Source);
+	}
+	else
+	{
+		TrajectoryCache.Empty();
 	}
 }
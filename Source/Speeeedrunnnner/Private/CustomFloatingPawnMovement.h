@@ -12,6 +12,37 @@
 #include "GameFramework/PawnMovementComponent.h"
 #include "CustomFloatingPawnMovement.generated.h"
 
+/** Result of a ballistic path prediction (see UCustomFloatingPawnMovement::PredictTrajectory) */
+USTRUCT(BlueprintType)
+struct FPawnTrajectory
+{
+	GENERATED_BODY()
+
+	/** Simulated pawn locations, one per simulation step, ending at the landing point */
+	UPROPERTY(BlueprintReadOnly, Category = Trajectory)
+	TArray<FVector> Points;
+
+	/** True if the path ends on something (wall or ground), false if it ran out of time */
+	UPROPERTY(BlueprintReadOnly, Category = Trajectory)
+	bool bLanded = false;
+
+	/** Pawn location where the path ends */
+	UPROPERTY(BlueprintReadOnly, Category = Trajectory)
+	FVector LandingLocation = FVector::ZeroVector;
+
+	/** Pawn velocity when the path ends */
+	UPROPERTY(BlueprintReadOnly, Category = Trajectory)
+	FVector LandingVelocity = FVector::ZeroVector;
+
+	/** Seconds from launch until the path ends */
+	UPROPERTY(BlueprintReadOnly, Category = Trajectory)
+	float FlightTime = 0.f;
+
+	/** What the path ended on, valid when bLanded */
+	UPROPERTY(BlueprintReadOnly, Category = Trajectory)
+	FHitResult Hit;
+};
+
 /**
  * FloatingPawnMovement is a movement component that provides simple movement for any Pawn class.
  * Limits on speed and acceleration are provided, while gravity is not implemented.
@@ -65,6 +96,12 @@ protected:
 	/** Update Velocity based on input. Also applies gravity. */
 	virtual void ApplyControlInputToVelocity(float DeltaTime);
 
+	/** Ground branch of ApplyControlInputToVelocity, shared with the trajectory prediction. ControlAcceleration must be clamped to size 1. */
+	FVector ComputeGroundHorizontalVelocity(const FVector& HorizontalVelocity, const FVector& ControlAcceleration, float DeltaTime) const;
+
+	/** Air branch of ApplyControlInputToVelocity, shared with the trajectory prediction. ControlAcceleration must be clamped to size 1. */
+	FVector ComputeAirHorizontalVelocity(const FVector& HorizontalVelocity, const FVector& ControlAcceleration, float DeltaTime) const;
+
 	/** Prevent Pawn from leaving the world bounds (if that restriction is enabled in WorldSettings) */
 	virtual bool LimitWorldBounds();
 
@@ -116,7 +153,84 @@ protected:
 	/** Apply friction based on ground state */
 	virtual void ApplyGroundFriction(float DeltaTime);
 
+	/** Friction math of ApplyGroundFriction, shared with the trajectory prediction */
+	FVector ComputeGroundFrictionVelocity(const FVector& InVelocity, const FVector& GroundNormal, bool bSteepSlope, float DeltaTime) const;
+
+	/** True if a ground with this normal is steeper than MaxWalkableAngle, relative to the gravity direction */
+	bool IsSteepGround(const FVector& GroundNormal) const;
+
 	/** The last ground hit result */
 	FHitResult LastGroundHit;
+
+public:
+	/** Vertical acceleration applied while airborne (GravityScale * GravityForce * GravityMultiplier) */
+	UFUNCTION(BlueprintPure, Category=FloatingPawnMovement)
+	float GetAirGravityZ() const { return GravityScale * GravityForce * GravityMultiplier; }
+
+	/** Simulation step used by the trajectory prediction (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="FloatingPawnMovement|Trajectory", meta=(ClampMin="0.005", UIMin="0.005"))
+	float TrajectorySimStep;
+
+	/** Longest flight the trajectory prediction simulates (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="FloatingPawnMovement|Trajectory", meta=(ClampMin="0.1", UIMin="0.1"))
+	float TrajectoryMaxTime;
+
+	/** Maximum number of path segments that are swept against the world. Steps are grouped into this many chords. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="FloatingPawnMovement|Trajectory", meta=(ClampMin="1", UIMin="1"))
+	int32 TrajectoryMaxSweeps;
+
+	/** A cached trajectory is reused while start location and velocity stay within this distance (uu and uu/s) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="FloatingPawnMovement|Trajectory", meta=(ClampMin="0", UIMin="0"))
+	float TrajectoryCacheTolerance;
+
+	/** How many stale cached trajectories may be re-simulated per frame, the rest keep their previous result until a later frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="FloatingPawnMovement|Trajectory", meta=(ClampMin="1", UIMin="1"))
+	int32 MaxTrajectoryRebuildsPerFrame;
+
+	/**
+	 * Predicts the path of the pawn from StartLocation with LaunchVelocity, stepping the same math as the tick:
+	 * gravity, the ground check, the ground or air branch of the input, and ground friction while within GroundTraceDistance of the ground.
+	 * AirInput is the movement input held during the flight (zero for none).
+	 * IgnoredActor is left out of the body sweeps, pass the launch pad so a start location touching it does not count as a landing.
+	 * Ends when the pawn would hit something or when the ground check of the tick would find ground.
+	 * @return true if the path lands within TrajectoryMaxTime.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false, Category="FloatingPawnMovement|Trajectory")
+	bool PredictTrajectory(const FVector& StartLocation, const FVector& LaunchVelocity, const FVector& AirInput, FPawnTrajectory& OutTrajectory, const AActor* IgnoredActor = nullptr) const;
+
+	/**
+	 * Same as PredictTrajectory, but the result is cached per Source (a launch pad, a jump start, an AI racer...).
+	 * The cached path is only re-simulated when the inputs or the movement settings change, limited by MaxTrajectoryRebuildsPerFrame.
+	 * The actor of Source is ignored by the body sweeps.
+	 * @param bOutUpToDate false if OutTrajectory is a stale (or, for a new Source, empty) result still waiting for its rebuild.
+	 * @return true if the path lands within TrajectoryMaxTime.
+	 */
+	UFUNCTION(BlueprintCallable, Category="FloatingPawnMovement|Trajectory")
+	bool GetCachedTrajectory(const UObject* Source, const FVector& StartLocation, const FVector& LaunchVelocity, const FVector& AirInput, FPawnTrajectory& OutTrajectory, bool& bOutUpToDate);
+
+	/** Drops the cached trajectory of Source, or every cached trajectory when Source is null (e.g. after level geometry changes) */
+	UFUNCTION(BlueprintCallable, Category="FloatingPawnMovement|Trajectory")
+	void InvalidateTrajectoryCache(const UObject* Source = nullptr);
+
+protected:
+	/** Hash of every setting the trajectory prediction depends on, a cached path is rebuilt when it changes */
+	uint32 GetTrajectorySettingsHash() const;
+
+	struct FCachedTrajectory
+	{
+		FVector StartLocation;
+		FVector LaunchVelocity;
+		FVector AirInput;
+		uint32 SettingsHash = 0;
+		bool bBuilt = false;
+		FPawnTrajectory Trajectory;
+	};
+
+	/** Cached predictions, keyed by the object that asked for them */
+	TMap<TWeakObjectPtr<const UObject>, FCachedTrajectory> TrajectoryCache;
+
+	/** Frame of the last trajectory rebuild and how many were done in it */
+	uint64 TrajectoryRebuildFrame = 0;
+	int32 TrajectoryRebuildsThisFrame = 0;
 };
 
@@ -0,0 +1,359 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitchDetectorSubsystem.h"
+#include "Async/Async.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "RenderCore.h"
+#include "UObject/UObjectGlobals.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HitchDetectorSubsystem)
+
+const float UHitchDetectorSubsystem::HistogramBucketMs[] = { 4.f, 8.f, 12.f, 16.7f, 20.f, 25.f, 33.3f, 50.f, 66.7f, 100.f, 250.f, TNumericLimits<float>::Max() };
+const int32 UHitchDetectorSubsystem::NumHistogramBuckets = UE_ARRAY_COUNT(UHitchDetectorSubsystem::HistogramBucketMs);
+
+UHitchDetectorSubsystem* UHitchDetectorSubsystem::ActiveInstance = nullptr;
+
+static const FName MovementScopeName(TEXT("Movement"));
+
+FHitchScope::FHitchScope(FName InName)
+	: Name(InName)
+	, StartCycles(FPlatformTime::Cycles())
+{
+}
+
+FHitchScope::~FHitchScope()
+{
+	UHitchDetectorSubsystem::AddScopeTime(Name, FPlatformTime::Cycles() - StartCycles);
+}
+
+bool UHitchDetectorSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_BUILD_SHIPPING
+	return false;
+#else
+	// Chamado no CDO, que já tem os valores do DefaultGame.ini.
+	// Um detector por processo: no PIE com vários clientes só o primeiro GameInstance ganha um.
+	return bEnabled && ActiveInstance == nullptr && Super::ShouldCreateSubsystem(Outer);
+#endif
+}
+
+void UHitchDetectorSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (ActiveInstance != nullptr)
+	{
+		return;
+	}
+	ActiveInstance = this;
+
+	HistogramCounts.SetNumZeroed(NumHistogramBuckets);
+	RingBuffer.SetNum(FMath::Max(RingBufferFrames, 1));
+	RingBufferHead = 0;
+	FrameScopes.Reserve(16);
+
+	BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddUObject(this, &UHitchDetectorSubsystem::OnBeginFrame);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UHitchDetectorSubsystem::OnEndFrame);
+	AsyncLoadingFlushHandle = FCoreDelegates::OnAsyncLoadingFlush.AddUObject(this, &UHitchDetectorSubsystem::OnAsyncLoadingFlush);
+	PreGCHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UHitchDetectorSubsystem::OnPreGarbageCollect);
+	PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UHitchDetectorSubsystem::OnPostGarbageCollect);
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UHitchDetectorSubsystem::OnPreLoadMap);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UHitchDetectorSubsystem::OnPostLoadMap);
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UHitchDetectorSubsystem::OnLevelAddedToWorld);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UHitchDetectorSubsystem::OnLevelRemovedFromWorld);
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UHitchDetectorSubsystem::OnWorldTickStart);
+	WorldPreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UHitchDetectorSubsystem::OnWorldPreActorTick);
+	WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UHitchDetectorSubsystem::OnWorldPostActorTick);
+}
+
+void UHitchDetectorSubsystem::Deinitialize()
+{
+	if (ActiveInstance == this)
+	{
+		ActiveInstance = nullptr;
+
+		FCoreDelegates::OnBeginFrame.Remove(BeginFrameHandle);
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		FCoreDelegates::OnAsyncLoadingFlush.Remove(AsyncLoadingFlushHandle);
+		FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGCHandle);
+		FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+		FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+		FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+		FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+		FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+		FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+		FWorldDelegates::OnWorldPreActorTick.Remove(WorldPreActorTickHandle);
+		FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
+	}
+
+	Super::Deinitialize();
+}
+
+void UHitchDetectorSubsystem::AddScopeTime(FName Name, uint32 Cycles)
+{
+	UHitchDetectorSubsystem* Detector = ActiveInstance;
+	if (!Detector || !IsInGameThread())
+	{
+		return;
+	}
+
+	const float Ms = FPlatformTime::ToMilliseconds(Cycles);
+	for (FHitchScopeTime& Scope : Detector->FrameScopes)
+	{
+		if (Scope.Name == Name)
+		{
+			Scope.Ms += Ms;
+			return;
+		}
+	}
+	Detector->FrameScopes.Add({ Name, Ms });
+}
+
+void UHitchDetectorSubsystem::OnBeginFrame()
+{
+	FrameScopes.Reset();
+	CurrentFrame = FHitchFrameSample();
+	FrameGCCycles = 0;
+	FrameLoadMapCycles = 0;
+	FrameLoadMapGCCycles = 0;
+	FrameWorldPreActorTickCycles = 0;
+	FrameActorTickCycles = 0;
+}
+
+void UHitchDetectorSubsystem::OnEndFrame()
+{
+	const uint32 EndCycles = FPlatformTime::Cycles();
+
+	// Primeiro frame: ainda não temos o fim do frame anterior para medir
+	if (LastFrameEndCycles == 0)
+	{
+		LastFrameEndCycles = EndCycles;
+		return;
+	}
+
+	FHitchFrameSample& Sample = RingBuffer[RingBufferHead];
+	Sample = CurrentFrame;
+	Sample.FrameNumber = GFrameCounter;
+	Sample.FrameMs = FPlatformTime::ToMilliseconds(EndCycles - LastFrameEndCycles);
+	// Begin->EndFrame inclui o sleep do max tick rate e a espera do render thread, então usamos o tempo de game thread da engine
+	Sample.GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	Sample.WorldPreActorTickMs = FPlatformTime::ToMilliseconds(FrameWorldPreActorTickCycles);
+	Sample.ActorTickMs = FPlatformTime::ToMilliseconds(FrameActorTickCycles);
+	Sample.GCMs = FPlatformTime::ToMilliseconds(FrameGCCycles);
+	Sample.LoadMapMs = FPlatformTime::ToMilliseconds(FrameLoadMapCycles);
+	Sample.LoadMapGCMs = FPlatformTime::ToMilliseconds(FrameLoadMapGCCycles);
+	Sample.AsyncPackagesPending = GetNumAsyncPackages();
+	for (const FHitchScopeTime& Scope : FrameScopes)
+	{
+		if (Scope.Name == MovementScopeName)
+		{
+			Sample.MovementMs = Scope.Ms;
+			break;
+		}
+	}
+
+	RingBufferHead = (RingBufferHead + 1) % RingBuffer.Num();
+	LastFrameEndCycles = EndCycles;
+
+	int32 Bucket = 0;
+	while (Bucket < NumHistogramBuckets - 1 && Sample.FrameMs > HistogramBucketMs[Bucket])
+	{
+		++Bucket;
+	}
+	++HistogramCounts[Bucket];
+
+	if (Sample.FrameMs > HitchThresholdMs)
+	{
+		++HitchCount;
+
+		const double Now = FPlatformTime::Seconds();
+		if (ReportsWritten < MaxReportsPerSession && (LastReportTime < 0.0 || Now - LastReportTime >= MinSecondsBetweenReports))
+		{
+			LastReportTime = Now;
+			++ReportsWritten;
+			QueueHitchReport(Sample);
+		}
+	}
+}
+
+void UHitchDetectorSubsystem::OnPreGarbageCollect()
+{
+	GCStartCycles = FPlatformTime::Cycles();
+}
+
+void UHitchDetectorSubsystem::OnPostGarbageCollect()
+{
+	// O LoadMap roda um GC por dentro: esse tempo já está no LoadMapMs, então não conta como GC de topo
+	const uint32 GCCycles = FPlatformTime::Cycles() - GCStartCycles;
+	if (bInLoadMap)
+	{
+		FrameLoadMapGCCycles += GCCycles;
+	}
+	else
+	{
+		FrameGCCycles += GCCycles;
+	}
+}
+
+void UHitchDetectorSubsystem::OnPreLoadMap(const FString& MapName)
+{
+	LoadMapStartCycles = FPlatformTime::Cycles();
+	bInLoadMap = true;
+}
+
+void UHitchDetectorSubsystem::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	FrameLoadMapCycles += FPlatformTime::Cycles() - LoadMapStartCycles;
+	bInLoadMap = false;
+}
+
+void UHitchDetectorSubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	++CurrentFrame.LevelsAdded;
+}
+
+void UHitchDetectorSubsystem::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	++CurrentFrame.LevelsRemoved;
+}
+
+void UHitchDetectorSubsystem::OnAsyncLoadingFlush()
+{
+	++CurrentFrame.AsyncLoadingFlushes;
+}
+
+void UHitchDetectorSubsystem::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	WorldTickStartCycles = FPlatformTime::Cycles();
+}
+
+void UHitchDetectorSubsystem::OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	ActorTickStartCycles = FPlatformTime::Cycles();
+	FrameWorldPreActorTickCycles += ActorTickStartCycles - WorldTickStartCycles;
+}
+
+void UHitchDetectorSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	FrameActorTickCycles += FPlatformTime::Cycles() - ActorTickStartCycles;
+}
+
+TArray<FHitchFrameSample> UHitchDetectorSubsystem::GetOrderedSamples() const
+{
+	TArray<FHitchFrameSample> Samples;
+	Samples.Reserve(RingBuffer.Num());
+	for (int32 Offset = 0; Offset < RingBuffer.Num(); ++Offset)
+	{
+		const FHitchFrameSample& Sample = RingBuffer[(RingBufferHead + Offset) % RingBuffer.Num()];
+		if (Sample.FrameNumber != 0)
+		{
+			Samples.Add(Sample);
+		}
+	}
+	return Samples;
+}
+
+void UHitchDetectorSubsystem::QueueHitchReport(const FHitchFrameSample& HitchFrame)
+{
+	// No game thread só copiamos os dados, formatar e escrever fica para a thread pool
+	FString LevelName = TEXT("None");
+	float PawnSpeed = 0.f;
+	if (const UWorld* World = GetGameInstance() ? GetGameInstance()->GetWorld() : nullptr)
+	{
+		LevelName = World->GetMapName();
+		if (const APlayerController* PlayerController = World->GetFirstPlayerController())
+		{
+			if (const APawn* Pawn = PlayerController->GetPawn())
+			{
+				PawnSpeed = Pawn->GetVelocity().Size();
+			}
+		}
+	}
+
+	// Fases de topo do game thread; o que sobra (input, render commands, audio, slate...) vira "Other"
+	TArray<FHitchScopeTime> Scopes = FrameScopes;
+	Scopes.Add({ TEXT("World.PreActorTick"), HitchFrame.WorldPreActorTickMs });
+	Scopes.Add({ TEXT("World.ActorTick"), HitchFrame.ActorTickMs });
+	Scopes.Add({ TEXT("GarbageCollection"), HitchFrame.GCMs });
+	Scopes.Add({ TEXT("LoadMap"), HitchFrame.LoadMapMs });
+	// Filho do LoadMap: aparece na lista, mas não é descontado de novo do game thread
+	Scopes.Add({ TEXT("LoadMap/GC"), HitchFrame.LoadMapGCMs });
+	const float TrackedMs = HitchFrame.WorldPreActorTickMs + HitchFrame.ActorTickMs + HitchFrame.GCMs + HitchFrame.LoadMapMs;
+	Scopes.Add({ TEXT("GameThread.Other"), FMath::Max(HitchFrame.GameThreadMs - TrackedMs, 0.f) });
+
+	const FString FilePath = FPaths::ProjectSavedDir() / TEXT("Hitches") / FString::Printf(TEXT("Hitch_%s_%llu.txt"), *FDateTime::Now().ToString(), HitchFrame.FrameNumber);
+
+	Async(EAsyncExecution::ThreadPool, [FilePath, LevelName, PawnSpeed, HitchFrame, Scopes = MoveTemp(Scopes), Samples = GetOrderedSamples(), MaxScopes = MaxScopesInReport, ThresholdMs = HitchThresholdMs]() mutable
+	{
+		Scopes.Sort([](const FHitchScopeTime& A, const FHitchScopeTime& B) { return A.Ms > B.Ms; });
+
+		FString Report;
+		Report += FString::Printf(TEXT("Hitch report (threshold %.1f ms)\n"), ThresholdMs);
+		Report += FString::Printf(TEXT("Level: %s\n"), *LevelName);
+		Report += FString::Printf(TEXT("Pawn speed: %.0f uu/s\n"), PawnSpeed);
+		Report += FString::Printf(TEXT("Frame %llu: %.2f ms (game thread %.2f, world pre-actor tick %.2f, actor tick %.2f, movement %.2f, GC %.2f, load map %.2f of which GC %.2f)\n"),
+			HitchFrame.FrameNumber, HitchFrame.FrameMs, HitchFrame.GameThreadMs, HitchFrame.WorldPreActorTickMs, HitchFrame.ActorTickMs, HitchFrame.MovementMs, HitchFrame.GCMs, HitchFrame.LoadMapMs, HitchFrame.LoadMapGCMs);
+		Report += FString::Printf(TEXT("Streaming: %d levels added, %d removed, %d async loading flushes, %d packages pending\n\n"),
+			HitchFrame.LevelsAdded, HitchFrame.LevelsRemoved, HitchFrame.AsyncLoadingFlushes, HitchFrame.AsyncPackagesPending);
+
+		Report += TEXT("Most expensive scopes:\n");
+		for (int32 Index = 0; Index < Scopes.Num() && Index < MaxScopes; ++Index)
+		{
+			if (Scopes[Index].Ms > 0.f)
+			{
+				Report += FString::Printf(TEXT("  %-24s %8.2f ms\n"), *Scopes[Index].Name.ToString(), Scopes[Index].Ms);
+			}
+		}
+
+		Report += TEXT("\nFrame,FrameMs,GameThreadMs,WorldPreActorTickMs,ActorTickMs,MovementMs,GCMs,LoadMapMs,LoadMapGCMs,LevelsAdded,LevelsRemoved,AsyncLoadingFlushes,AsyncPackagesPending\n");
+		for (const FHitchFrameSample& Sample : Samples)
+		{
+			Report += FString::Printf(TEXT("%llu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%d,%d,%d,%d\n"),
+				Sample.FrameNumber, Sample.FrameMs, Sample.GameThreadMs, Sample.WorldPreActorTickMs, Sample.ActorTickMs, Sample.MovementMs, Sample.GCMs, Sample.LoadMapMs, Sample.LoadMapGCMs,
+				Sample.LevelsAdded, Sample.LevelsRemoved, Sample.AsyncLoadingFlushes, Sample.AsyncPackagesPending);
+		}
+
+		FFileHelper::SaveStringToFile(Report, *FilePath);
+	});
+}
+
+void UHitchDetectorSubsystem::WriteHistogramReport() const
+{
+	const FString FilePath = FPaths::ProjectSavedDir() / TEXT("Hitches") / FString::Printf(TEXT("Histogram_%s.txt"), *FDateTime::Now().ToString());
+
+	Async(EAsyncExecution::ThreadPool, [FilePath, Counts = HistogramCounts, HitchTotal = HitchCount]()
+	{
+		int64 TotalFrames = 0;
+		for (const int64 Count : Counts)
+		{
+			TotalFrames += Count;
+		}
+
+		FString Report = FString::Printf(TEXT("Frames: %lld  Hitches: %d\n\n"), TotalFrames, HitchTotal);
+		float LowerMs = 0.f;
+		for (int32 Bucket = 0; Bucket < Counts.Num(); ++Bucket)
+		{
+			const float Percent = TotalFrames > 0 ? 100.f * Counts[Bucket] / TotalFrames : 0.f;
+			if (Bucket < Counts.Num() - 1)
+			{
+				Report += FString::Printf(TEXT("%6.1f - %6.1f ms: %10lld (%5.1f%%)\n"), LowerMs, HistogramBucketMs[Bucket], Counts[Bucket], Percent);
+				LowerMs = HistogramBucketMs[Bucket];
+			}
+			else
+			{
+				Report += FString::Printf(TEXT("%6.1f+        ms: %10lld (%5.1f%%)\n"), LowerMs, Counts[Bucket], Percent);
+			}
+		}
+
+		FFileHelper::SaveStringToFile(Report, *FilePath);
+	});
+}
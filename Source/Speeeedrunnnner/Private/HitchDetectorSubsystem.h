@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "HitchDetectorSubsystem.generated.h"
+
+/** Times of one frame, in milliseconds, plus the streaming/loading activity seen in it */
+struct FHitchFrameSample
+{
+	uint64 FrameNumber = 0;
+	float FrameMs = 0.f;
+	/** Game thread work as reported by the engine (GGameThreadTime, the "Game" value of stat unit), without sleeps and render sync waits */
+	float GameThreadMs = 0.f;
+	/** UWorld::Tick before actor ticking (net dispatch, world and streaming updates) */
+	float WorldPreActorTickMs = 0.f;
+	/** Actor and component tick groups */
+	float ActorTickMs = 0.f;
+	float MovementMs = 0.f;
+	/** Garbage collection outside LoadMap */
+	float GCMs = 0.f;
+	/** Synchronous LoadMap (OpenLevel, travel), including the GC it runs */
+	float LoadMapMs = 0.f;
+	/** Garbage collection run inside LoadMap, already counted in LoadMapMs */
+	float LoadMapGCMs = 0.f;
+	int32 LevelsAdded = 0;
+	int32 LevelsRemoved = 0;
+	/** Blocking FlushAsyncLoading calls, a common cause of streaming hitches */
+	int32 AsyncLoadingFlushes = 0;
+	/** Packages still waiting in the async loader at the end of the frame */
+	int32 AsyncPackagesPending = 0;
+};
+
+/** Time spent in one named scope during the current frame */
+struct FHitchScopeTime
+{
+	FName Name;
+	float Ms = 0.f;
+};
+
+/**
+ * Measures the game thread time of the enclosing block and adds it to the current frame of the hitch detector.
+ * Use through HITCH_SCOPE, which compiles out in Shipping.
+ */
+struct FHitchScope
+{
+	explicit FHitchScope(FName InName);
+	~FHitchScope();
+
+private:
+	FName Name;
+	uint32 StartCycles;
+};
+
+#if !UE_BUILD_SHIPPING
+#define HITCH_SCOPE(Name) static const FName PREPROCESSOR_JOIN(HitchScopeName_, __LINE__)(TEXT(#Name)); FHitchScope PREPROCESSOR_JOIN(HitchScope_, __LINE__)(PREPROCESSOR_JOIN(HitchScopeName_, __LINE__))
+#else
+#define HITCH_SCOPE(Name)
+#endif
+
+/**
+ * Records a frame-time histogram and a ring buffer of the last frames (see FHitchFrameSample).
+ * When a frame goes over HitchThresholdMs a hitch report is written to Saved/Hitches, on a worker thread.
+ *
+ * Only exists in Development and Test builds, and only when bEnabled is set in the
+ * [/Script/Speeeedrunnnner.HitchDetectorSubsystem] section of DefaultGame.ini (off by default).
+ * Only one detector runs per process, so multi-client PIE does not write duplicate reports.
+ */
+UCLASS(Config = Game)
+class UHitchDetectorSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//Begin USubsystem Interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//End USubsystem Interface
+
+	/** Master switch, read from config */
+	UPROPERTY(Config)
+	bool bEnabled = false;
+
+	/** Frames longer than this are reported as hitches */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "Hitch")
+	float HitchThresholdMs = 50.f;
+
+	/** How many frames the ring buffer keeps (600 is ~5 seconds at 120 fps) */
+	UPROPERTY(Config)
+	int32 RingBufferFrames = 600;
+
+	/** Minimum time between two hitch reports, so a long loading screen does not write hundreds of files */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "Hitch")
+	float MinSecondsBetweenReports = 2.f;
+
+	/** Reports written per session are capped, so a slow machine does not fill Saved/Hitches */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "Hitch")
+	int32 MaxReportsPerSession = 20;
+
+	/** How many of the most expensive scopes go into a report */
+	UPROPERTY(Config, BlueprintReadWrite, Category = "Hitch")
+	int32 MaxScopesInReport = 8;
+
+	/** Number of hitches seen since the game started */
+	UFUNCTION(BlueprintPure, Category = "Hitch")
+	int32 GetHitchCount() const { return HitchCount; }
+
+	/** Writes the frame-time histogram to Saved/Hitches, off the game thread */
+	UFUNCTION(BlueprintCallable, Category = "Hitch")
+	void WriteHistogramReport() const;
+
+	/** Called by FHitchScope when a scope ends */
+	static void AddScopeTime(FName Name, uint32 Cycles);
+
+protected:
+	void OnBeginFrame();
+	void OnEndFrame();
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+	void OnPreLoadMap(const FString& MapName);
+	void OnPostLoadMap(UWorld* LoadedWorld);
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+	void OnAsyncLoadingFlush();
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** Copies what the report needs and hands the formatting and file write to a worker thread */
+	void QueueHitchReport(const FHitchFrameSample& HitchFrame);
+
+	/** Frame samples in chronological order, oldest first */
+	TArray<FHitchFrameSample> GetOrderedSamples() const;
+
+	/** Upper edge (ms) of each histogram bucket, the last bucket takes everything above */
+	static const float HistogramBucketMs[];
+	static const int32 NumHistogramBuckets;
+
+	/** The active detector, used by the static scope hook. Null when disabled. */
+	static UHitchDetectorSubsystem* ActiveInstance;
+
+	TArray<int64> HistogramCounts;
+
+	TArray<FHitchFrameSample> RingBuffer;
+	int32 RingBufferHead = 0;
+
+	/** Scopes measured during the current frame */
+	TArray<FHitchScopeTime> FrameScopes;
+
+	/** Cycle stamps of the current frame */
+	uint32 LastFrameEndCycles = 0;
+	uint32 GCStartCycles = 0;
+	uint32 LoadMapStartCycles = 0;
+	uint32 WorldTickStartCycles = 0;
+	uint32 ActorTickStartCycles = 0;
+
+	/** Accumulated for the current frame */
+	FHitchFrameSample CurrentFrame;
+	uint32 FrameGCCycles = 0;
+	uint32 FrameLoadMapCycles = 0;
+	uint32 FrameLoadMapGCCycles = 0;
+
+	/** Between PreLoadMap and PostLoadMap, GC in this window belongs to LoadMap */
+	bool bInLoadMap = false;
+	uint32 FrameWorldPreActorTickCycles = 0;
+	uint32 FrameActorTickCycles = 0;
+
+	int32 HitchCount = 0;
+	int32 ReportsWritten = 0;
+	double LastReportTime = -1.0;
+
+	FDelegateHandle BeginFrameHandle;
+	FDelegateHandle EndFrameHandle;
+	FDelegateHandle PreGCHandle;
+	FDelegateHandle PostGCHandle;
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+	FDelegateHandle AsyncLoadingFlushHandle;
+	FDelegateHandle WorldTickStartHandle;
+	FDelegateHandle WorldPreActorTickHandle;
+	FDelegateHandle WorldPostActorTickHandle;
+};
@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpeedrunHUDSubsystem.h"
+#include "CustomFloatingPawnMovement.h"
+#include "SpeedrunRunTimerSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "TimerManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(SpeedrunHUDSubsystem)
+
+bool USpeedrunHUDSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer))
+	{
+		return false;
+	}
+
+	// Só faz sentido em mundos de jogo com tela (nada de editor preview nem dedicated server)
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_DedicatedServer;
+}
+
+void USpeedrunHUDSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	StartUpdateTimer();
+}
+
+void USpeedrunHUDSubsystem::StartUpdateTimer()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	// SetTimer no mesmo handle substitui o timer anterior
+	const float Interval = 1.f / FMath::Max(UpdateRate, 1.f);
+	World->GetTimerManager().SetTimer(UpdateTimerHandle, this, &USpeedrunHUDSubsystem::UpdateModel, Interval, true);
+}
+
+void USpeedrunHUDSubsystem::SetUpdateRate(float NewUpdateRate)
+{
+	UpdateRate = FMath::Max(NewUpdateRate, 1.f);
+
+	// Antes do BeginPlay o timer ainda não existe, o OnWorldBeginPlay já vai usar o valor novo
+	if (UpdateTimerHandle.IsValid())
+	{
+		StartUpdateTimer();
+	}
+}
+
+void USpeedrunHUDSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(UpdateTimerHandle);
+	}
+
+	Super::Deinitialize();
+}
+
+void USpeedrunHUDSubsystem::RefreshAll()
+{
+	OnSpeedChanged.Broadcast(LastSpeed, SpeedText);
+	OnRunTimeChanged.Broadcast(LastRunTime, RunTimeText);
+	OnNetStatsChanged.Broadcast(FMath::Max(LastPingMs, 0), LastLossPercent, NetStatsText);
+}
+
+void USpeedrunHUDSubsystem::UpdateModel()
+{
+	UpdateSpeed();
+	UpdateRunTime();
+	UpdateNetStats();
+}
+
+void USpeedrunHUDSubsystem::UpdateSpeed()
+{
+	const UCustomFloatingPawnMovement* Movement = GetLocalMovement();
+	const float Speed = Movement ? Movement->Velocity.Size() : 0.f;
+
+	// Quantiza antes de comparar, assim jitter pequeno não gera repaint
+	const float Step = FMath::Max(SpeedStep, 1.f);
+	const int32 SpeedSteps = FMath::RoundToInt(Speed / Step);
+	if (SpeedSteps == LastSpeedStep)
+	{
+		return;
+	}
+
+	LastSpeedStep = SpeedSteps;
+	LastSpeed = SpeedSteps * Step;
+	SpeedText = FText::AsNumber(FMath::RoundToInt(LastSpeed));
+	OnSpeedChanged.Broadcast(LastSpeed, SpeedText);
+}
+
+void USpeedrunHUDSubsystem::UpdateRunTime()
+{
+	const UWorld* World = GetWorld();
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	const USpeedrunRunTimerSubsystem* RunTimer = GameInstance ? GameInstance->GetSubsystem<USpeedrunRunTimerSubsystem>() : nullptr;
+	if (!RunTimer)
+	{
+		return;
+	}
+
+	const double RunTime = FMath::Max(RunTimer->GetRunTimeSeconds(), 0.0);
+
+	// O texto mostra décimos, então só muda 10x por segundo no máximo
+	const int32 Tenths = FMath::FloorToInt(RunTime * 10.0);
+	if (Tenths == LastRunTimeTenths)
+	{
+		return;
+	}
+
+	LastRunTimeTenths = Tenths;
+	LastRunTime = Tenths / 10.f;
+
+	const int32 Minutes = Tenths / 600;
+	const int32 Seconds = (Tenths / 10) % 60;
+	const int32 Tenth = Tenths % 10;
+	RunTimeText = FText::FromString(FString::Printf(TEXT("%02d:%02d.%d"), Minutes, Seconds, Tenth));
+	OnRunTimeChanged.Broadcast(LastRunTime, RunTimeText);
+}
+
+void USpeedrunHUDSubsystem::UpdateNetStats()
+{
+	const UWorld* World = GetWorld();
+	const APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	if (!PlayerController)
+	{
+		return;
+	}
+
+	int32 PingMs = 0;
+	if (const APlayerState* PlayerState = PlayerController->GetPlayerState<APlayerState>())
+	{
+		PingMs = FMath::RoundToInt(PlayerState->GetPingInMilliseconds());
+	}
+
+	float LossPercent = 0.f;
+	if (const UNetConnection* Connection = PlayerController->GetNetConnection())
+	{
+		LossPercent = Connection->GetInLossPercentage().GetAvgLossPercentage() * 100.f;
+	}
+
+	const int32 LossTenths = FMath::RoundToInt(LossPercent * 10.f);
+	if (PingMs == LastPingMs && LossTenths == LastLossTenths)
+	{
+		return;
+	}
+
+	LastPingMs = PingMs;
+	LastLossTenths = LossTenths;
+	LastLossPercent = LossTenths / 10.f;
+	NetStatsText = FText::FromString(FString::Printf(TEXT("%d ms  %.1f%% loss"), PingMs, LastLossPercent));
+	OnNetStatsChanged.Broadcast(PingMs, LastLossPercent, NetStatsText);
+}
+
+UCustomFloatingPawnMovement* USpeedrunHUDSubsystem::GetLocalMovement()
+{
+	const UWorld* World = GetWorld();
+	const APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+	// Só procura o componente de novo quando o pawn muda (respawn, possess)
+	if (Pawn != CachedPawn.Get())
+	{
+		CachedPawn = Pawn;
+		CachedMovement = Pawn ? Pawn->FindComponentByClass<UCustomFloatingPawnMovement>() : nullptr;
+	}
+
+	return CachedMovement.Get();
+}
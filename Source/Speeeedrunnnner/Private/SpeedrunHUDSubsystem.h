@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SpeedrunHUDSubsystem.generated.h"
+
+class UCustomFloatingPawnMovement;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHUDSpeedChanged, float, Speed, const FText&, SpeedText);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHUDRunTimeChanged, float, RunTimeSeconds, const FText&, RunTimeText);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnHUDNetStatsChanged, int32, PingMs, float, PacketLossPercent, const FText&, NetStatsText);
+
+/**
+ * HUD model for the local player: speed, run time (from USpeedrunRunTimerSubsystem) and net stats.
+ *
+ * Values are sampled on a timer at UpdateRate, quantized, and only broadcast through the OnXxxChanged events
+ * when the quantized value changes. The FText for each value is cached, so formatting only happens on change.
+ *
+ * USpeedrunHUDWidget is the widget side. The existing widget Blueprints (BP_WidgetRede, Blueprints/Widgets)
+ * still use per-frame bindings until they are reparented to it.
+ */
+UCLASS()
+class USpeedrunHUDSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//Begin UWorldSubsystem Interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	//End UWorldSubsystem Interface
+
+	/** How many times per second the HUD values are sampled, change it with SetUpdateRate */
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float UpdateRate = 10.f;
+
+	/** Speed is rounded to this step (uu/s) before comparing, so tiny jitter does not repaint the widget */
+	UPROPERTY(BlueprintReadWrite, Category = "HUD")
+	float SpeedStep = 10.f;
+
+	UPROPERTY(BlueprintAssignable, Category = "HUD")
+	FOnHUDSpeedChanged OnSpeedChanged;
+
+	UPROPERTY(BlueprintAssignable, Category = "HUD")
+	FOnHUDRunTimeChanged OnRunTimeChanged;
+
+	UPROPERTY(BlueprintAssignable, Category = "HUD")
+	FOnHUDNetStatsChanged OnNetStatsChanged;
+
+	/** Changes UpdateRate and restarts the sampling timer with the new interval */
+	UFUNCTION(BlueprintCallable, Category = "HUD")
+	void SetUpdateRate(float NewUpdateRate);
+
+	/** Rebroadcasts every cached value, used by widgets right after they bind */
+	UFUNCTION(BlueprintCallable, Category = "HUD")
+	void RefreshAll();
+
+	UFUNCTION(BlueprintPure, Category = "HUD")
+	FText GetSpeedText() const { return SpeedText; }
+
+	UFUNCTION(BlueprintPure, Category = "HUD")
+	FText GetRunTimeText() const { return RunTimeText; }
+
+	UFUNCTION(BlueprintPure, Category = "HUD")
+	FText GetNetStatsText() const { return NetStatsText; }
+
+protected:
+	/** (Re)starts the sampling timer at UpdateRate */
+	void StartUpdateTimer();
+
+	/** Samples every value and broadcasts the ones that changed */
+	void UpdateModel();
+
+	void UpdateSpeed();
+	void UpdateRunTime();
+	void UpdateNetStats();
+
+	/** Finds the movement component of the first local player's pawn, cached until the pawn changes */
+	UCustomFloatingPawnMovement* GetLocalMovement();
+
+	FTimerHandle UpdateTimerHandle;
+
+	TWeakObjectPtr<APawn> CachedPawn;
+	TWeakObjectPtr<UCustomFloatingPawnMovement> CachedMovement;
+
+	/** Last broadcast (quantized) values, INDEX_NONE forces the first broadcast */
+	int32 LastSpeedStep = INDEX_NONE;
+	int32 LastRunTimeTenths = INDEX_NONE;
+	int32 LastPingMs = INDEX_NONE;
+	int32 LastLossTenths = INDEX_NONE;
+
+	float LastSpeed = 0.f;
+	float LastRunTime = 0.f;
+	float LastLossPercent = 0.f;
+
+	FText SpeedText;
+	FText RunTimeText;
+	FText NetStatsText;
+};
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpeedrunHUDWidget.h"
+#include "SpeedrunHUDSubsystem.h"
+#include "Components/TextBlock.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(SpeedrunHUDWidget)
+
+void USpeedrunHUDWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	if (USpeedrunHUDSubsystem* HUDModel = GetWorld() ? GetWorld()->GetSubsystem<USpeedrunHUDSubsystem>() : nullptr)
+	{
+		HUDModel->OnSpeedChanged.AddUniqueDynamic(this, &USpeedrunHUDWidget::HandleSpeedChanged);
+		HUDModel->OnRunTimeChanged.AddUniqueDynamic(this, &USpeedrunHUDWidget::HandleRunTimeChanged);
+		HUDModel->OnNetStatsChanged.AddUniqueDynamic(this, &USpeedrunHUDWidget::HandleNetStatsChanged);
+
+		// Pega os valores atuais logo de cara, sem esperar a próxima mudança
+		HUDModel->RefreshAll();
+	}
+}
+
+void USpeedrunHUDWidget::NativeDestruct()
+{
+	if (USpeedrunHUDSubsystem* HUDModel = GetWorld() ? GetWorld()->GetSubsystem<USpeedrunHUDSubsystem>() : nullptr)
+	{
+		HUDModel->OnSpeedChanged.RemoveDynamic(this, &USpeedrunHUDWidget::HandleSpeedChanged);
+		HUDModel->OnRunTimeChanged.RemoveDynamic(this, &USpeedrunHUDWidget::HandleRunTimeChanged);
+		HUDModel->OnNetStatsChanged.RemoveDynamic(this, &USpeedrunHUDWidget::HandleNetStatsChanged);
+	}
+
+	Super::NativeDestruct();
+}
+
+void USpeedrunHUDWidget::HandleSpeedChanged(float Speed, const FText& SpeedText)
+{
+	if (SpeedTextBlock)
+	{
+		SpeedTextBlock->SetText(SpeedText);
+	}
+}
+
+void USpeedrunHUDWidget::HandleRunTimeChanged(float RunTimeSeconds, const FText& RunTimeText)
+{
+	if (RunTimeTextBlock)
+	{
+		RunTimeTextBlock->SetText(RunTimeText);
+	}
+}
+
+void USpeedrunHUDWidget::HandleNetStatsChanged(int32 PingMs, float PacketLossPercent, const FText& NetStatsText)
+{
+	if (NetStatsTextBlock)
+	{
+		NetStatsTextBlock->SetText(NetStatsText);
+	}
+}
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "SpeedrunHUDWidget.generated.h"
+
+class UTextBlock;
+
+/**
+ * Base class for HUD widgets that show speed, run time and net stats.
+ *
+ * Listens to USpeedrunHUDSubsystem and only sets the text when a value changes, so the widget needs
+ * no per-frame bindings. Reparent the widget Blueprint to this class, name the text blocks
+ * SpeedTextBlock / RunTimeTextBlock / NetStatsTextBlock (all optional), and put them inside an
+ * Invalidation Box (Retainer Box for the speed/timer group) so Slate only repaints them on change.
+ */
+UCLASS(Abstract)
+class USpeedrunHUDWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+protected:
+	//Begin UUserWidget Interface
+	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
+	//End UUserWidget Interface
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD", meta = (BindWidgetOptional))
+	TObjectPtr<UTextBlock> SpeedTextBlock;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD", meta = (BindWidgetOptional))
+	TObjectPtr<UTextBlock> RunTimeTextBlock;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD", meta = (BindWidgetOptional))
+	TObjectPtr<UTextBlock> NetStatsTextBlock;
+
+	UFUNCTION()
+	void HandleSpeedChanged(float Speed, const FText& SpeedText);
+
+	UFUNCTION()
+	void HandleRunTimeChanged(float RunTimeSeconds, const FText& RunTimeText);
+
+	UFUNCTION()
+	void HandleNetStatsChanged(int32 PingMs, float PacketLossPercent, const FText& NetStatsText);
+};
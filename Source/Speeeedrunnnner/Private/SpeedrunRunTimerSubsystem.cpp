@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpeedrunRunTimerSubsystem.h"
+#include "HAL/PlatformTime.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(SpeedrunRunTimerSubsystem)
+
+void USpeedrunRunTimerSubsystem::StartRun()
+{
+	AccumulatedSeconds = 0.0;
+	SegmentStartSeconds = FPlatformTime::Seconds();
+	bRunning = true;
+}
+
+void USpeedrunRunTimerSubsystem::StopRun()
+{
+	if (!bRunning)
+	{
+		return;
+	}
+
+	AccumulatedSeconds += FPlatformTime::Seconds() - SegmentStartSeconds;
+	bRunning = false;
+}
+
+void USpeedrunRunTimerSubsystem::ResumeRun()
+{
+	if (bRunning)
+	{
+		return;
+	}
+
+	SegmentStartSeconds = FPlatformTime::Seconds();
+	bRunning = true;
+}
+
+void USpeedrunRunTimerSubsystem::ResetRun()
+{
+	AccumulatedSeconds = 0.0;
+	bRunning = false;
+}
+
+double USpeedrunRunTimerSubsystem::GetRunTimeSeconds() const
+{
+	// Tempo real (não o do mundo), assim pause e time dilation não mexem no timer
+	return bRunning ? AccumulatedSeconds + (FPlatformTime::Seconds() - SegmentStartSeconds) : AccumulatedSeconds;
+}
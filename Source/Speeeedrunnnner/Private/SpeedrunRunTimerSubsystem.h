@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "SpeedrunRunTimerSubsystem.generated.h"
+
+/**
+ * The run timer. Lives in the GameInstance, so a run keeps counting across Level1 -> Level2 -> Level3,
+ * and uses real time, so it ignores game pause and time dilation.
+ *
+ * The timer only moves between StartRun and StopRun; the level/goal Blueprints own those calls.
+ */
+UCLASS()
+class USpeedrunRunTimerSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Starts a new run from zero */
+	UFUNCTION(BlueprintCallable, Category = "Run")
+	void StartRun();
+
+	/** Stops the run, the time stays frozen at its final value */
+	UFUNCTION(BlueprintCallable, Category = "Run")
+	void StopRun();
+
+	/** Resumes a stopped run without resetting it */
+	UFUNCTION(BlueprintCallable, Category = "Run")
+	void ResumeRun();
+
+	/** Clears the run back to zero and stops it */
+	UFUNCTION(BlueprintCallable, Category = "Run")
+	void ResetRun();
+
+	UFUNCTION(BlueprintPure, Category = "Run")
+	bool IsRunning() const { return bRunning; }
+
+	/** Real seconds counted so far in the current run */
+	UFUNCTION(BlueprintPure, Category = "Run")
+	double GetRunTimeSeconds() const;
+
+protected:
+	/** Time accumulated by previous Start/Resume -> Stop segments */
+	double AccumulatedSeconds = 0.0;
+
+	/** FPlatformTime::Seconds() when the current segment started */
+	double SegmentStartSeconds = 0.0;
+
+	bool bRunning = false;
+};